@@ -6,6 +6,8 @@
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <vector>
+#include <utility>
 
 namespace fs = std::filesystem;
 
@@ -40,6 +42,7 @@ private:
     std::string branch_;
     std::string commitMsg_;
     nlohmann::json hash_db_;
+    nlohmann::json etag_cache_;
     
     // Progress display state
     std::string currentFile_;
@@ -47,6 +50,21 @@ private:
     int totalFiles_ = 0;
     std::string hashFile_ = "data/hash_db.json";
     std::string configFile_ = "data/config.json";
+    std::string etagCacheFile_ = "data/etag_cache.json";
+    size_t maxEtagCacheEntries_ = 64;
+
+    // Folder uploads collect text blobs and commit them together at the end
+    bool batchTextCommits_ = false;
+    std::vector<std::pair<std::string, nlohmann::json>> pendingTextFiles_;  // local path, tree entry
+
+    // Single-file text commits take 6 requests instead of 2; below this size
+    // the extra round trips cost more than skipping base64 saves
+    size_t minSingleTextBlobBytes_ = 16 * 1024;
+
+    // Wire accounting: request bodies sent vs. what base64-only PUTs would have sent
+    size_t wireBytesSent_ = 0;
+    size_t wireBytesBase64_ = 0;
+    int textUploads_ = 0;
 
     // Progress display components
     std::atomic<bool> progressActive_{false};
@@ -56,13 +74,33 @@ private:
     // Helper methods
     std::string sanitizeRepoPath(const std::string& basePath);
     std::string sha256File(const std::string& filePath);
+    std::string gitBlobSHA(const std::string& content);
     std::string base64Encode(const std::string& input);
     std::string getFileSHA(const std::string& pathInRepo);
+    bool apiGet(const std::string& url, nlohmann::json& response, bool useCache = true);
+    long apiWrite(const std::string& method, const std::string& url,
+                  const std::string& body, nlohmann::json& response);
     bool putFileToGitHub(const std::string& filePath, const std::string& pathInRepo);
+    bool putContentsToGitHub(const std::string& content, const std::string& normalizedPath);
+
+    // Text uploads (UTF-8 blobs via the Git Data API)
+    bool isUtf8Text(const std::string& data);
+    void appendJsonEscaped(std::string& out, const std::string& input);
+    bool loadBranchHead(std::string& commitSha, std::string& treeSha);
+    bool createTextBlob(const std::string& content, std::string& blobSha);
+    nlohmann::json withBaseTreeModes(const nlohmann::json& entries, const std::string& treeSha);
+    bool commitTextTree(const nlohmann::json& entries, bool& refAttempted);
+    std::vector<std::string> flushTextCommit();
+    void resetWireStats();
+    void printWireReport();
 
     // Hash tracking
     void loadHashDB();
     void saveHashDB();
+
+    // Conditional request cache (ETag / Last-Modified per URL)
+    void loadEtagCache();
+    void saveEtagCache();
     
     // Progress display methods
     void startProgress();
@@ -12,6 +12,8 @@
 #include <atomic>
 #include <mutex>
 #include <cstring>  
+#include <cctype>
+#include <cstdint>
 
 namespace fs = std::filesystem;
 
@@ -25,6 +27,7 @@ void GitHubUploader::setCommitMessage(const std::string& msg) { commitMsg_ = msg
 
 GitHubUploader::GitHubUploader() {
     loadHashDB();
+    loadEtagCache();
 }
 
 
@@ -49,6 +52,27 @@ static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* use
     return size * nmemb;
 }
 
+// Callback function for CURL to capture the validators (ETag / Last-Modified)
+// from response headers. Header names are case-insensitive (HTTP/2 sends lowercase).
+static size_t HeaderCallback(char* buffer, size_t size, size_t nitems, void* userp) {
+    size_t len = size * nitems;
+    std::string line(buffer, len);
+    size_t colon = line.find(':');
+    if (colon == std::string::npos) return len;
+
+    std::string name = line.substr(0, colon);
+    std::transform(name.begin(), name.end(), name.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+
+    std::string value = line.substr(colon + 1);
+    value.erase(0, value.find_first_not_of(" \t"));
+    value.erase(value.find_last_not_of(" \t\r\n") + 1);
+
+    auto* validators = static_cast<std::unordered_map<std::string, std::string>*>(userp);
+    if (name == "etag" || name == "last-modified") (*validators)[name] = value;
+    return len;
+}
+
 // Base64 encoding helper
 std::string GitHubUploader::base64Encode(const std::string& input) {
     static const char* base64_chars = 
@@ -96,51 +120,411 @@ std::string GitHubUploader::base64Encode(const std::string& input) {
     return ret;
 }
 
+// UTF-8 text classifier: true if the data is valid UTF-8 with no NUL bytes.
+// ASCII runs are checked 8 bytes at a time (SWAR); multi-byte sequences are
+// validated strictly (no overlongs, surrogates or code points above U+10FFFF).
+bool GitHubUploader::isUtf8Text(const std::string& data) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data());
+    const size_t n = data.size();
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+    size_t i = 0;
+
+    while (i < n) {
+        // Fast path: whole words of ASCII
+        while (i + 8 <= n) {
+            uint64_t w;
+            std::memcpy(&w, p + i, 8);
+            if (w & highs) break;                       // non-ASCII byte in this word
+            if ((w - ones) & ~w & highs) return false;  // contains a NUL byte
+            i += 8;
+        }
+        if (i >= n) break;
+
+        unsigned char c = p[i];
+        if (c == 0) return false;
+        if (c < 0x80) { ++i; continue; }
+
+        size_t len;
+        uint32_t cp;
+        if ((c & 0xE0) == 0xC0)      { len = 2; cp = c & 0x1F; }
+        else if ((c & 0xF0) == 0xE0) { len = 3; cp = c & 0x0F; }
+        else if ((c & 0xF8) == 0xF0) { len = 4; cp = c & 0x07; }
+        else return false;
+
+        if (i + len > n) return false;
+        for (size_t k = 1; k < len; ++k) {
+            if ((p[i + k] & 0xC0) != 0x80) return false;
+            cp = (cp << 6) | (p[i + k] & 0x3F);
+        }
+
+        if ((len == 2 && cp < 0x80) || (len == 3 && cp < 0x800) || (len == 4 && cp < 0x10000))
+            return false;  // overlong encoding
+        if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+            return false;
+        i += len;
+    }
+    return true;
+}
+
+// Append input to out as the body of a JSON string, escaping in a single pass.
+// Runs of bytes that need no escaping are copied in bulk.
+void GitHubUploader::appendJsonEscaped(std::string& out, const std::string& input) {
+    static const char* hex = "0123456789abcdef";
+    out.reserve(out.size() + input.size() + input.size() / 16 + 2);
+
+    size_t runStart = 0;
+    for (size_t i = 0; i < input.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(input[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        out.append(input, runStart, i - runStart);
+        runStart = i + 1;
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            default:
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 0x0F];
+        }
+    }
+    out.append(input, runStart, std::string::npos);
+}
+
+// Reduce a response to the fields callers read back from the cache, so entries
+// stay small (a contents response would otherwise carry the whole file as base64).
+static nlohmann::json cacheableFields(const nlohmann::json& body) {
+    nlohmann::json kept = nlohmann::json::object();
+    if (!body.is_object()) return kept;
+    if (body.contains("sha")) kept["sha"] = body["sha"];
+    for (const char* key : {"object", "tree"}) {
+        if (body.contains(key) && body[key].is_object() && body[key].contains("sha"))
+            kept[key]["sha"] = body[key]["sha"];
+    }
+    return kept;
+}
+
+static long long nowSeconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// GET against the GitHub API. With useCache, sends If-None-Match / If-Modified-Since
+// from the ETag cache; on 304 the cached fields are served without a body transfer
+// (GitHub does not count 304s against the primary rate limit). Only the fields kept
+// by cacheableFields() are available on a cache hit.
+bool GitHubUploader::apiGet(const std::string& url, nlohmann::json& response, bool useCache) {
+    CURL* curl = curl_easy_init();
+    if (!curl) return false;
+
+    std::string readBuffer;
+    std::unordered_map<std::string, std::string> validators;
+
+    struct curl_slist* headers = nullptr;
+    headers = curl_slist_append(headers, ("Authorization: Bearer " + token_).c_str());
+    headers = curl_slist_append(headers, "Accept: application/vnd.github.v3+json");
+    headers = curl_slist_append(headers, "User-Agent: GitHubUploader");
+
+    auto cached = useCache ? etag_cache_.find(url) : etag_cache_.end();
+    if (cached != etag_cache_.end()) {
+        std::string etag = cached->value("etag", "");
+        std::string lastModified = cached->value("last_modified", "");
+        if (!etag.empty())
+            headers = curl_slist_append(headers, ("If-None-Match: " + etag).c_str());
+        if (!lastModified.empty())
+            headers = curl_slist_append(headers, ("If-Modified-Since: " + lastModified).c_str());
+    }
+
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, HeaderCallback);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &validators);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+
+    CURLcode res = curl_easy_perform(curl);
+    long response_code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
+    curl_slist_free_all(headers);
+    curl_easy_cleanup(curl);
+
+    if (res != CURLE_OK) return false;
+
+    // Not modified: reuse the cached payload
+    if (response_code == 304 && cached != etag_cache_.end() && cached->contains("body")) {
+        response = (*cached)["body"];
+        (*cached)["last_used"] = nowSeconds();
+        return true;
+    }
+
+    if (response_code != 200) {
+        if (useCache && response_code == 404) etag_cache_.erase(url);  // resource is gone
+        return false;
+    }
+
+    try {
+        response = nlohmann::json::parse(readBuffer);
+    } catch (...) {
+        return false;
+    }
+
+    // Only cache responses that carry a validator we can send back
+    if (useCache && (validators.count("etag") || validators.count("last-modified"))) {
+        nlohmann::json entry;
+        entry["etag"] = validators["etag"];
+        entry["last_modified"] = validators["last-modified"];
+        entry["body"] = cacheableFields(response);
+        entry["last_used"] = nowSeconds();
+        etag_cache_[url] = entry;
+    }
+    return true;
+}
+
 // Get the SHA of an existing file from GitHub (needed for updates)
 std::string GitHubUploader::getFileSHA(const std::string& pathInRepo) {
+    std::string url = "https://api.github.com/repos/" + repo_ + "/contents/" + pathInRepo;
+
+    // Cached: files whose remote SHA already matches are not re-PUT, so their
+    // ETag stays valid and the next run's read comes back as a 304
+    nlohmann::json response;
+    if (!apiGet(url, response)) return "";
+
+    // Directory listings come back as arrays; only a file object carries a SHA
+    if (response.is_object() && response.contains("sha") && response["sha"].is_string()) {
+        return response["sha"].get<std::string>();
+    }
+
+    return "";
+}
+
+// Send a JSON body with the given method (POST/PATCH) to the GitHub API.
+// Returns the HTTP status code, or -1 if the request could not be made.
+long GitHubUploader::apiWrite(const std::string& method, const std::string& url,
+                              const std::string& body, nlohmann::json& response) {
     CURL* curl = curl_easy_init();
-    if (!curl) return "";
+    if (!curl) return -1;
 
     std::string readBuffer;
-    std::string url = "https://api.github.com/repos/" + repo_ + "/contents/" + pathInRepo;
-    
     struct curl_slist* headers = nullptr;
     headers = curl_slist_append(headers, ("Authorization: Bearer " + token_).c_str());
     headers = curl_slist_append(headers, "Accept: application/vnd.github.v3+json");
+    headers = curl_slist_append(headers, "Content-Type: application/json");
     headers = curl_slist_append(headers, "User-Agent: GitHubUploader");
 
     curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, method.c_str());
     curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.data());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(body.size()));
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
     curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
 
     CURLcode res = curl_easy_perform(curl);
+    long response_code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
     curl_slist_free_all(headers);
     curl_easy_cleanup(curl);
 
-    if (res != CURLE_OK) return "";
+    if (res != CURLE_OK) {
+        std::cerr << "CURL error: " << curl_easy_strerror(res) << std::endl;
+        return -1;
+    }
+    wireBytesSent_ += body.size();  // sent even if the server rejected it
 
-    // Parse JSON response to get SHA
     try {
-        auto response = nlohmann::json::parse(readBuffer);
-        if (response.contains("sha")) {
-            return response["sha"].get<std::string>();
-        }
+        response = nlohmann::json::parse(readBuffer);
     } catch (...) {
-        // File doesn't exist or parse error
+        response = nlohmann::json();
     }
+    return response_code;
+}
 
-    return "";
+// Resolve the branch head commit and its tree (the ref read goes through the ETag cache)
+bool GitHubUploader::loadBranchHead(std::string& commitSha, std::string& treeSha) {
+    std::string base = "https://api.github.com/repos/" + repo_ + "/git/";
+
+    nlohmann::json ref;
+    if (!apiGet(base + "ref/heads/" + branch_, ref)) return false;
+    if (!ref.is_object() || !ref.contains("object")) return false;
+    commitSha = ref["object"].value("sha", "");
+    if (commitSha.empty()) return false;
+
+    nlohmann::json commit;
+    // Commits are immutable and the SHA changes with every push: no point caching
+    if (!apiGet(base + "commits/" + commitSha, commit, false)) return false;
+    if (!commit.is_object() || !commit.contains("tree")) return false;
+    treeSha = commit["tree"].value("sha", "");
+    return !treeSha.empty();
+}
+
+// Create a blob from UTF-8 text, sending the content as raw (JSON-escaped) text
+// instead of base64. The payload is built directly so the content is escaped once.
+bool GitHubUploader::createTextBlob(const std::string& content, std::string& blobSha) {
+    std::string body = "{\"encoding\":\"utf-8\",\"content\":\"";
+    appendJsonEscaped(body, content);
+    body += "\"}";
+
+    nlohmann::json blob;
+    long code = apiWrite("POST", "https://api.github.com/repos/" + repo_ + "/git/blobs", body, blob);
+
+    if (code != 201 || !blob.contains("sha")) {
+        std::cerr << "GitHub API error creating blob (HTTP " << code << "): " << blob.dump() << std::endl;
+        return false;
+    }
+    blobSha = blob["sha"].get<std::string>();
+    return true;
+}
+
+// Carry over the mode of paths that already exist in the base tree (e.g. an
+// executable script stays 100755), as the contents API does. New paths keep
+// the entry's default. One recursive read; tree SHAs are immutable, so uncached.
+nlohmann::json GitHubUploader::withBaseTreeModes(const nlohmann::json& entries, const std::string& treeSha) {
+    nlohmann::json result = entries;
+
+    nlohmann::json tree;
+    std::string url = "https://api.github.com/repos/" + repo_ + "/git/trees/" + treeSha + "?recursive=1";
+    if (!apiGet(url, tree, false) || !tree.is_object() || !tree.contains("tree")) return result;
+
+    std::unordered_map<std::string, std::string> modes;
+    for (const auto& item : tree["tree"]) {
+        std::string mode = item.value("mode", "");
+        if (mode == "100644" || mode == "100755") modes[item.value("path", "")] = mode;  // not symlinks
+    }
+
+    for (auto& entry : result) {
+        auto it = modes.find(entry["path"].get<std::string>());
+        if (it != modes.end()) entry["mode"] = it->second;
+    }
+    return result;
+}
+
+// Commit tree entries on top of the branch head: one tree, one commit, one ref update.
+// The head is resolved here so contents-API uploads made earlier in the run are kept;
+// a 422 on the ref update (branch moved, not a fast-forward) refreshes it and retries once.
+// refAttempted is set once the ref update has been sent, since it may then have landed.
+bool GitHubUploader::commitTextTree(const nlohmann::json& entries, bool& refAttempted) {
+    refAttempted = false;
+    if (entries.empty()) return true;
+    std::string base = "https://api.github.com/repos/" + repo_ + "/git/";
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        std::string headCommit, headTree;
+        if (!loadBranchHead(headCommit, headTree)) {
+            std::cerr << "Error: Cannot resolve head of branch " << branch_ << " in " << repo_ << std::endl;
+            return false;
+        }
+
+        nlohmann::json treeReq;
+        treeReq["base_tree"] = headTree;
+        treeReq["tree"] = withBaseTreeModes(entries, headTree);
+        nlohmann::json tree;
+        long code = apiWrite("POST", base + "trees", treeReq.dump(), tree);
+        if (code != 201 || !tree.contains("sha")) {
+            std::cerr << "GitHub API error creating tree (HTTP " << code << "): " << tree.dump() << std::endl;
+            return false;
+        }
+
+        nlohmann::json commitReq;
+        commitReq["message"] = commitMsg_;
+        commitReq["tree"] = tree["sha"];
+        commitReq["parents"] = nlohmann::json::array({headCommit});
+        nlohmann::json commit;
+        code = apiWrite("POST", base + "commits", commitReq.dump(), commit);
+        if (code != 201 || !commit.contains("sha")) {
+            std::cerr << "GitHub API error creating commit (HTTP " << code << "): " << commit.dump() << std::endl;
+            return false;
+        }
+
+        nlohmann::json refReq;
+        refReq["sha"] = commit["sha"];
+        refReq["force"] = false;
+        nlohmann::json ref;
+        refAttempted = true;
+        code = apiWrite("PATCH", base + "refs/heads/" + branch_, refReq.dump(), ref);
+
+        // No answer or a server error: the update may still have been applied,
+        // so look at the ref itself (uncached) before calling it a failure
+        bool landed = code == 200;
+        if (code == -1 || code >= 500) {
+            nlohmann::json current;
+            if (apiGet(base + "ref/heads/" + branch_, current, false) &&
+                current.is_object() && current.contains("object")) {
+                landed = current["object"].value("sha", "") == commit["sha"].get<std::string>();
+            } else {
+                std::cerr << "Warning: Could not confirm whether branch " << branch_
+                          << " now points at commit " << commit["sha"].get<std::string>() << std::endl;
+            }
+        }
+
+        if (landed) {
+            // We just moved the ref, so its cached ETag can never validate again
+            etag_cache_.erase(base + "ref/heads/" + branch_);
+            textUploads_ += static_cast<int>(entries.size());
+            return true;
+        }
+        if (code == 422 && attempt == 0) {
+            refAttempted = false;  // rejected, so nothing landed
+            continue;
+        }
+
+        std::cerr << "GitHub API error updating branch " << branch_ << " (HTTP " << code << "): "
+                  << ref.dump() << std::endl;
+        return false;
+    }
+    return false;
+}
+
+// Commit the text files collected during a folder upload in one go.
+// Returns the local paths that did not reach the branch.
+std::vector<std::string> GitHubUploader::flushTextCommit() {
+    std::vector<std::string> failed;
+    batchTextCommits_ = false;
+    if (pendingTextFiles_.empty()) return failed;
+
+    std::cout << "Committing " << pendingTextFiles_.size() << " text file(s) to " << branch_ << "..." << std::endl;
+
+    nlohmann::json entries = nlohmann::json::array();
+    for (const auto& pending : pendingTextFiles_) entries.push_back(pending.second);
+
+    bool refAttempted = false;
+    if (!commitTextTree(entries, refAttempted)) {
+        if (!refAttempted)
+            std::cerr << "Warning: Text commit failed, uploading via the contents API instead" << std::endl;
+        else
+            std::cerr << "Warning: Branch " << branch_ << " update failed; "
+                      << pendingTextFiles_.size() << " text file(s) may not be committed" << std::endl;
+
+        for (const auto& pending : pendingTextFiles_) {
+            // Nothing reached the branch yet, so the files can still go up one by one
+            if (!refAttempted) {
+                std::ifstream file(pending.first, std::ios::binary);
+                if (file.is_open()) {
+                    std::string content((std::istreambuf_iterator<char>(file)),
+                                        std::istreambuf_iterator<char>());
+                    if (putContentsToGitHub(content, pending.second["path"].get<std::string>())) continue;
+                }
+            }
+            failed.push_back(pending.first);
+        }
+    }
+
+    pendingTextFiles_.clear();
+    return failed;
 }
 
 // Main GitHub upload function
 
 bool GitHubUploader::putFileToGitHub(const std::string& filePath, const std::string& pathInRepo) {
-    // Normalize repo path (remove leading slashes)
-    std::string normalizedPath = pathInRepo;
-    while (!normalizedPath.empty() && normalizedPath.front() == '/')
-        normalizedPath.erase(0, 1);
+    // Normalize repo path (slashes and "." components)
+    std::string normalizedPath = sanitizeRepoPath(pathInRepo);
 
     // Read file content
     std::ifstream file(filePath, std::ios::binary);
@@ -153,12 +537,48 @@ bool GitHubUploader::putFileToGitHub(const std::string& filePath, const std::str
                         std::istreambuf_iterator<char>());
     file.close();
 
-    // Base64 encode the content
-    std::string base64Content = base64Encode(content);
+    // What the base64-only PUT would have sent, for the wire report
+    // (its "sha" field is left out, which understates the saving slightly)
+    nlohmann::json putMeta = {{"message", commitMsg_}, {"content", ""}, {"branch", branch_}};
+    wireBytesBase64_ += putMeta.dump().size() + (content.size() + 2) / 3 * 4;
+
+    // Text files go up as UTF-8 blobs; binaries (or a failed text path) use base64.
+    // Outside a folder batch each text file costs its own tree/commit/ref round trips,
+    // so small files stay on the contents API.
+    bool worthTextPath = batchTextCommits_ || content.size() >= minSingleTextBlobBytes_;
+    if (worthTextPath && isUtf8Text(content)) {
+        std::string blobSha;
+        if (createTextBlob(content, blobSha)) {
+            nlohmann::json entry = {
+                {"path", normalizedPath}, {"mode", "100644"}, {"type", "blob"}, {"sha", blobSha}
+            };
+            if (batchTextCommits_) {
+                pendingTextFiles_.emplace_back(filePath, entry);
+                return true;  // committed by flushTextCommit()
+            }
+
+            bool refAttempted = false;
+            if (commitTextTree(nlohmann::json::array({entry}), refAttempted)) return true;
+            // The ref update may have landed; a base64 retry could commit the file twice
+            if (refAttempted) return false;
+        }
+        std::cerr << "Falling back to base64 upload for " << normalizedPath << std::endl;
+    }
 
+    return putContentsToGitHub(content, normalizedPath);
+}
+
+// Upload through the contents API (base64 payload, one commit per file)
+bool GitHubUploader::putContentsToGitHub(const std::string& content, const std::string& normalizedPath) {
     // Check if file exists to get its SHA (needed for updates)
     std::string existingSHA = getFileSHA(normalizedPath);
 
+    // Identical content is already on the branch: nothing to send
+    if (!existingSHA.empty() && existingSHA == gitBlobSHA(content)) return true;
+
+    // Base64 encode the content
+    std::string base64Content = base64Encode(content);
+
     // Prepare JSON payload
     nlohmann::json payload;
     payload["message"] = commitMsg_;
@@ -211,6 +631,7 @@ bool GitHubUploader::putFileToGitHub(const std::string& filePath, const std::str
         std::cerr << "CURL error: " << curl_easy_strerror(res) << std::endl;
         return false;
     }
+    wireBytesSent_ += jsonPayload.size();
 
     if (response_code == 200 || response_code == 201) {
         return true;  // Success
@@ -231,13 +652,21 @@ bool GitHubUploader::putFileToGitHub(const std::string& filePath, const std::str
 
 
 // === Path Cleanup ===
+// Repo paths go into tree entries verbatim, so drop empty and "." components
+// ("./src//a.cpp" -> "src/a.cpp"); the trees API rejects anything else.
 std::string GitHubUploader::sanitizeRepoPath(const std::string& basePath) {
-    if (basePath.empty() || basePath == ".") return "";
     std::string path = basePath;
     std::replace(path.begin(), path.end(), '\\', '/');
-    if (!path.empty() && path.front() == '/') path.erase(0,1);
-    if (!path.empty() && path.back() == '/') path.pop_back();
-    return path;
+
+    std::string result;
+    std::stringstream ss(path);
+    std::string part;
+    while (std::getline(ss, part, '/')) {
+        if (part.empty() || part == ".") continue;
+        if (!result.empty()) result += '/';
+        result += part;
+    }
+    return result;
 }
 
 // === Spinner Thread ===
@@ -278,12 +707,14 @@ void GitHubUploader::stopProgress() {
 void GitHubUploader::uploadFolder(const std::string& localFolder, const std::string& baseRepoPath) {
     std::string repoPath = sanitizeRepoPath(baseRepoPath);
     std::vector<std::string> files;
+    std::vector<std::string> repoPaths;
 
     for (auto& p : fs::recursive_directory_iterator(localFolder)) {
         if (p.is_regular_file()) {
             std::string relativePath = fs::relative(p.path(), localFolder).generic_string();
             std::string pathInRepo = repoPath.empty() ? relativePath : repoPath + "/" + relativePath;
             files.push_back(p.path().string());
+            repoPaths.push_back(sanitizeRepoPath(pathInRepo));
         }
     }
 
@@ -292,22 +723,32 @@ void GitHubUploader::uploadFolder(const std::string& localFolder, const std::str
         return;
     }
 
+    resetWireStats();
+    batchTextCommits_ = true;
+    pendingTextFiles_.clear();
     startProgress();
     for (size_t i = 0; i < files.size(); ++i) {
         updateProgress(files[i], i + 1, files.size());
-        putFileToGitHub(files[i], fs::relative(files[i], localFolder).generic_string());
+        putFileToGitHub(files[i], repoPaths[i]);
     }
     stopProgress();
+    for (const auto& f : flushTextCommit())
+        std::cerr << "Warning: Failed to upload " << f << std::endl;
+    saveEtagCache();
+    printWireReport();
 }
 
 
 
 void GitHubUploader::uploadFile(const std::string& localPath, const std::string& pathInRepo) {
+    resetWireStats();
     if (putFileToGitHub(localPath, pathInRepo)) {
         std::cout << "Uploaded: " << pathInRepo << "\n";
     } else {
         std::cout << "Failed: " << pathInRepo << "\n";
     }
+    saveEtagCache();
+    printWireReport();
 }
 
 // === Config & Hash DB ===
@@ -321,6 +762,60 @@ void GitHubUploader::saveHashDB() {
     out << hash_db_.dump(4);
 }
 
+void GitHubUploader::loadEtagCache() {
+    std::ifstream in(etagCacheFile_);
+    if (!in.is_open()) return;
+    try {
+        in >> etag_cache_;
+    } catch (...) {
+        etag_cache_ = nlohmann::json::object();  // corrupt cache: start fresh
+    }
+    if (!etag_cache_.is_object()) etag_cache_ = nlohmann::json::object();
+
+    // Shrink entries written before bodies were trimmed
+    for (auto& entry : etag_cache_) {
+        if (entry.is_object() && entry.contains("body"))
+            entry["body"] = cacheableFields(entry["body"]);
+    }
+}
+
+void GitHubUploader::saveEtagCache() {
+    // Cap the cache: evict least recently used entries first
+    while (etag_cache_.size() > maxEtagCacheEntries_) {
+        auto oldest = etag_cache_.begin();
+        for (auto it = etag_cache_.begin(); it != etag_cache_.end(); ++it) {
+            if (it->value("last_used", 0LL) < oldest->value("last_used", 0LL)) oldest = it;
+        }
+        etag_cache_.erase(oldest);
+    }
+
+    std::ofstream out(etagCacheFile_);
+    if (out.is_open()) out << etag_cache_.dump();
+}
+
+// === Wire Report ===
+void GitHubUploader::resetWireStats() {
+    wireBytesSent_ = 0;
+    wireBytesBase64_ = 0;
+    textUploads_ = 0;
+}
+
+void GitHubUploader::printWireReport() {
+    if (wireBytesBase64_ == 0) return;
+    std::cout << "Request bodies sent: " << wireBytesSent_ << " bytes (" << textUploads_
+              << " file(s) as UTF-8 text); base64-only uploads would have sent "
+              << wireBytesBase64_ << " bytes. ";
+
+    if (wireBytesSent_ > wireBytesBase64_) {
+        std::cout << "Sent " << (wireBytesSent_ - wireBytesBase64_) << " bytes more." << std::endl;
+        return;
+    }
+    size_t saved = wireBytesBase64_ - wireBytesSent_;
+    std::ostringstream percent;
+    percent << std::fixed << std::setprecision(1) << (100.0 * saved / wireBytesBase64_);
+    std::cout << "Saved " << saved << " bytes (" << percent.str() << "%)." << std::endl;
+}
+
 void GitHubUploader::saveSessionConfig() {
     nlohmann::json cfg;
     cfg["repo"] = repo_;
@@ -381,6 +876,28 @@ std::string GitHubUploader::sha256File(const std::string& filePath) {
     return ss.str();
 }
 
+// Git blob SHA-1 ("blob <size>\0" + content), as reported by the contents API
+std::string GitHubUploader::gitBlobSHA(const std::string& content) {
+    EVP_MD_CTX* context = EVP_MD_CTX_new();
+    if (!context) return "";
+
+    std::string header = "blob " + std::to_string(content.size());
+    unsigned char hash[EVP_MAX_MD_SIZE];
+    unsigned int lengthOfHash = 0;
+    bool ok = EVP_DigestInit_ex(context, EVP_sha1(), nullptr) == 1 &&
+              EVP_DigestUpdate(context, header.c_str(), header.size() + 1) == 1 &&  // includes '\0'
+              EVP_DigestUpdate(context, content.data(), content.size()) == 1 &&
+              EVP_DigestFinal_ex(context, hash, &lengthOfHash) == 1;
+    EVP_MD_CTX_free(context);
+    if (!ok) return "";
+
+    std::stringstream ss;
+    for (unsigned int i = 0; i < lengthOfHash; ++i) {
+        ss << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
+    }
+    return ss.str();
+}
+
 void GitHubUploader::uploadFolderIfChanged(const std::string& localFolder, const std::string& baseRepoPath) {
     std::cout << "Scanning folder for incremental upload: " << localFolder << std::endl;
 
@@ -460,13 +977,16 @@ void GitHubUploader::uploadFolderIfChanged(const std::string& localFolder, const
     }
 
     // Upload changed files with progress
+    resetWireStats();
+    batchTextCommits_ = true;
+    pendingTextFiles_.clear();
     startProgress();
     int index = 0;
     int total = static_cast<int>(changedFiles.size());
 
     for (const auto& file : changedFiles) {
-        std::string pathInRepo = baseRepoPath;
-        if (!pathInRepo.empty() && pathInRepo.back() != '/')
+        std::string pathInRepo = sanitizeRepoPath(baseRepoPath);
+        if (!pathInRepo.empty())
             pathInRepo += '/';
         pathInRepo += fs::relative(file, localFolder).generic_string(); // preserve folder structure
 
@@ -481,10 +1001,13 @@ void GitHubUploader::uploadFolderIfChanged(const std::string& localFolder, const
     }
 
     stopProgress();
+    for (const auto& f : flushTextCommit()) failedFiles.push_back(f);
     saveHashDB();
+    saveEtagCache();
 
     // Summary
     std::cout << "Incremental upload complete. " << total << " file(s) processed." << std::endl;
+    printWireReport();
     if (!failedFiles.empty()) {
         std::cout << "Files failed to upload:" << std::endl;
         for (const auto& f : failedFiles) std::cout << "  - " << f << std::endl;